@@ -147,6 +147,22 @@ public:
     }
   }
 
+  /**
+   * Constructor for an array over an existing buffer, such as one that
+   * wraps a memory-mapped file. The array takes over one use of the buffer.
+   *
+   * @param shape Shape.
+   * @param buffer Buffer.
+   */
+  template<IS_VALUE(T)>
+  Array(const F& shape, Buffer<T>* buffer) :
+      shape(shape),
+      buffer(buffer),
+      offset(0),
+      isView(false) {
+    //
+  }
+
   /**
    * Copy constructor.
    */
@@ -501,7 +517,9 @@ public:
    */
   ///@{
   /**
-   * Shrink a one-dimensional array in-place.
+   * Shrink a one-dimensional array in-place. The capacity of the buffer is
+   * retained, so that the array may be enlarged again without reallocation;
+   * use shrinkToFit() to release it.
    *
    * @tparam G Shape type.
    *
@@ -522,20 +540,12 @@ public:
         Array<T,F> tmp(shape, *this);
         swap(tmp);
       } else {
-        if (newSize == 0) {
-          release();
-        } else {
-          auto iter = begin() + shape.size();
-          auto last = end();
-          for (; iter != last; ++iter) {
-            iter->~T();
-          }
-          // ^ C++17 use std::destroy
-          auto oldBytes = Buffer<T>::size(volume());
-          auto newBytes = Buffer<T>::size(shape.volume());
-          buffer = (Buffer<T>*)libbirch::reallocate(buffer, oldBytes,
-              buffer->tid, newBytes);
+        auto iter = begin() + shape.size();
+        auto last = end();
+        for (; iter != last; ++iter) {
+          iter->~T();
         }
+        // ^ C++17 use std::destroy
         this->shape = shape;
       }
     }
@@ -543,7 +553,9 @@ public:
   }
 
   /**
-   * Enlarge a one-dimensional array in-place.
+   * Enlarge a one-dimensional array in-place. When the capacity of the
+   * buffer is insufficient, it is grown geometrically, so that a sequence of
+   * enlargements by one element has amortized constant cost.
    *
    * @tparam G Shape type.
    *
@@ -561,20 +573,70 @@ public:
     auto oldSize = size();
     auto newSize = shape.size();
     if (newSize > oldSize) {
+      auto newCapacity = std::max(newSize, 2*capacity());
       if (!buffer || isShared()) {
-        Array<T,F> tmp(shape, *this);
+        Array<T,F> tmp(shape, *this, newCapacity);
         swap(tmp);
       } else {
-        auto oldBytes = Buffer<T>::size(volume());
-        auto newBytes = Buffer<T>::size(shape.volume());
-        buffer = (Buffer<T>*)libbirch::reallocate(buffer, oldBytes,
-            buffer->tid, newBytes);
+        if (newSize > capacity()) {
+          reallocate(newCapacity);
+        }
         this->shape = shape;
       }
       std::uninitialized_fill(begin() + oldSize, begin() + newSize, x);
     }
     unlock();
   }
+
+  /**
+   * Ensure that a one-dimensional array has capacity for at least @p n
+   * elements, so that it may subsequently be enlarged to that size without
+   * reallocation.
+   *
+   * @param n Number of elements.
+   */
+  void reserve(const int64_t n) {
+    static_assert(F::count() == 1, "can only reserve one-dimensional arrays");
+    assert(!isView);
+
+    lock();
+    if (n > capacity()) {
+      if (!buffer || isShared()) {
+        Array<T,F> tmp(shape, *this, n);
+        swap(tmp);
+      } else {
+        reallocate(n);
+      }
+    }
+    unlock();
+  }
+
+  /**
+   * Release any capacity of a one-dimensional array beyond its current
+   * size.
+   */
+  void shrinkToFit() {
+    static_assert(F::count() == 1, "can only shrink one-dimensional arrays");
+    assert(!isView);
+
+    lock();
+    if (buffer && !isShared() && capacity() > volume()) {
+      if (volume() == 0) {
+        release();
+      } else {
+        reallocate(volume());
+      }
+    }
+    unlock();
+  }
+
+  /**
+   * Number of elements for which space is allocated. For a view, this is
+   * zero.
+   */
+  int64_t capacity() const {
+    return !isView && buffer ? buffer->capacity : 0;
+  }
   ///@}
 
   /**
@@ -732,6 +794,19 @@ private:
     uninitialized_copy(o);
   }
 
+  /**
+   * Constructor for forced copy with additional capacity.
+   */
+  template<class U, class G>
+  Array(const F& shape, const Array<U,G>& o, const int64_t capacity) :
+      shape(shape.compact()),
+      buffer(nullptr),
+      offset(0),
+      isView(false) {
+    allocate(std::max(capacity, volume()));
+    uninitialized_copy(o);
+  }
+
   /**
    * Constructor for views.
    */
@@ -747,14 +822,15 @@ private:
    * Raw pointer to underlying buffer.
    */
   T* buf() const {
-    return buffer->buf() + offset;
+    return buffer ? buffer->buf() + offset : nullptr;
   }
 
   /**
-   * Is the buffer shared with one or more other arrays?
+   * Is the buffer shared with one or more other arrays? A memory-mapped
+   * buffer is always considered shared, as it is read-only.
    */
   bool isShared() const {
-    return buffer && buffer->numUsage() > 1u;
+    return buffer && (buffer->numUsage() > 1u || buffer->isMapped());
   }
 
   /**
@@ -772,27 +848,60 @@ private:
    * Allocate memory for array, leaving uninitialized.
    */
   void allocate() {
+    allocate(volume());
+  }
+
+  /**
+   * Allocate memory for array, leaving uninitialized.
+   *
+   * @param capacity Number of elements for which to allocate space, at least
+   * the volume of the array.
+   */
+  void allocate(const int64_t capacity) {
     assert(!buffer);
-    auto bytes = Buffer<T>::size(volume());
+    assert(capacity >= volume());
+    auto bytes = Buffer<T>::size(capacity);
     if (bytes > 0u) {
-      buffer = new (libbirch::allocate(bytes)) Buffer<T>();
+      buffer = new (libbirch::allocate(bytes)) Buffer<T>(capacity);
       offset = 0;
     }
   }
 
+  /**
+   * Reallocate memory for an unshared array, preserving its contents.
+   *
+   * @param capacity Number of elements for which to allocate space, at least
+   * the volume of the array.
+   */
+  void reallocate(const int64_t capacity) {
+    assert(buffer);
+    assert(!isShared());
+    assert(capacity >= volume());
+    auto oldBytes = Buffer<T>::size(buffer->capacity);
+    auto newBytes = Buffer<T>::size(capacity);
+    buffer = (Buffer<T>*)libbirch::reallocate(buffer, oldBytes, buffer->tid,
+        newBytes);
+    buffer->capacity = capacity;
+  }
+
   /**
    * Deallocate memory of array.
    */
   void release() {
     if (!isView && buffer && buffer->decUsage() == 0) {
-      auto iter = begin();
-      auto last = end();
-      for (; iter != last; ++iter) {
-        iter->~T();
+      if (buffer->isMapped()) {
+        buffer->unmap();
+        libbirch::deallocate(buffer, sizeof(Buffer<T>), buffer->tid);
+      } else {
+        auto iter = begin();
+        auto last = end();
+        for (; iter != last; ++iter) {
+          iter->~T();
+        }
+        // ^ C++17 use std::destroy
+        size_t bytes = Buffer<T>::size(buffer->capacity);
+        libbirch::deallocate(buffer, bytes, buffer->tid);
       }
-      // ^ C++17 use std::destroy
-      size_t bytes = Buffer<T>::size(volume());
-      libbirch::deallocate(buffer, bytes, buffer->tid);
     }
     buffer = nullptr;
     offset = 0;
@@ -0,0 +1,274 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+#include "libbirch/assert.hpp"
+#include "libbirch/stacktrace.hpp"
+#include "libbirch/memory.hpp"
+#include "libbirch/Shape.hpp"
+#include "libbirch/Buffer.hpp"
+#include "libbirch/Array.hpp"
+
+namespace libbirch {
+/**
+ * Header of a binary array file.
+ *
+ * @ingroup libbirch
+ *
+ * A binary array file consists of this header, followed by the length of
+ * each dimension and then the stride of each dimension (each as a 64-bit
+ * integer), followed by padding up to `offset` bytes from the start of the
+ * file, followed by the elements of the array. All values are
+ * little-endian. The offset is a multiple of 64 bytes, so that the elements
+ * are suitably aligned when the file is memory mapped. Strides are given in
+ * elements, with the rightmost dimension the fastest moving (for a matrix,
+ * this is "row major" order), as for Array.
+ */
+struct ArrayFileHeader {
+  /**
+   * Magic number, the characters `BIRCHARR`.
+   */
+  char magic[8];
+
+  /**
+   * Version of the format, currently 1.
+   */
+  uint32_t version;
+
+  /**
+   * Element type, as given by array_file_type.
+   */
+  uint32_t type;
+
+  /**
+   * Number of dimensions.
+   */
+  uint32_t ndims;
+
+  /**
+   * Offset of the first element from the start of the file, in bytes.
+   */
+  uint32_t offset;
+};
+
+/**
+ * Element type code of a binary array file.
+ *
+ * @ingroup libbirch
+ */
+template<class T>
+struct array_file_type {
+  //
+};
+template<>
+struct array_file_type<double> {
+  static const uint32_t value = 1;
+};
+template<>
+struct array_file_type<int64_t> {
+  static const uint32_t value = 2;
+};
+template<>
+struct array_file_type<bool> {
+  static_assert(sizeof(bool) == 1, "bool must be one byte");
+  static const uint32_t value = 3;
+};
+
+/**
+ * Shape of a given number of dimensions, constructed from lengths and
+ * strides.
+ */
+template<int D>
+struct array_file_shape {
+  static auto make(const int64_t* lengths, const int64_t* strides) {
+    using shape_type = typename DefaultShape<D>::type;
+    return shape_type(Dimension<>(lengths[0], strides[0]),
+        array_file_shape<D - 1>::make(lengths + 1, strides + 1));
+  }
+};
+template<>
+struct array_file_shape<0> {
+  static auto make(const int64_t* lengths, const int64_t* strides) {
+    return EmptyShape();
+  }
+};
+
+/**
+ * Lengths and strides of a vector or matrix, compact in row-major order,
+ * for the header of a binary array file. Each number of dimensions is a
+ * separate specialization, so that neither writes past the end of `dims`.
+ */
+template<int D>
+struct array_file_dims {
+  //
+};
+template<>
+struct array_file_dims<1> {
+  template<class T, class F>
+  static void make(const Array<T,F>& x, int64_t* dims) {
+    dims[0] = x.rows();
+    dims[1] = 1;
+  }
+};
+template<>
+struct array_file_dims<2> {
+  template<class T, class F>
+  static void make(const Array<T,F>& x, int64_t* dims) {
+    dims[0] = x.rows();
+    dims[1] = x.cols();
+    dims[2] = x.cols();
+    dims[3] = 1;
+  }
+};
+
+/**
+ * Load an array from a binary array file.
+ *
+ * @ingroup libbirch
+ *
+ * @tparam T Value type.
+ * @tparam D Number of dimensions.
+ *
+ * @param path Path of the file.
+ *
+ * @return The array.
+ *
+ * The file is memory mapped, and the contents of the returned array are
+ * those of the mapping, without copying. The array is read-only;
+ * copy-on-write is performed on the first write, as for any shared array.
+ */
+template<class T, int D>
+Array<T,typename DefaultShape<D>::type> load_array(const std::string& path) {
+  using shape_type = typename DefaultShape<D>::type;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  libbirch::abort("binary array files are little-endian, and cannot be "
+      "loaded on this big-endian platform");
+#endif
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  libbirch_error_msg_(fd >= 0, "could not open file " << path << ".");
+  struct stat st;
+  libbirch_error_msg_(::fstat(fd, &st) == 0, "could not open file " <<
+      path << ".");
+  size_t bytes = st.st_size;
+  libbirch_error_msg_(bytes >= sizeof(ArrayFileHeader), path <<
+      " is not a binary array file.");
+  void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  libbirch_error_msg_(mapping != MAP_FAILED, "could not map file " <<
+      path << ".");
+
+  /* validate header */
+  auto header = (const ArrayFileHeader*)mapping;
+  libbirch_error_msg_(std::memcmp(header->magic, "BIRCHARR", 8) == 0,
+      path << " is not a binary array file.");
+  libbirch_error_msg_(header->version == 1, path <<
+      " has unsupported version " << header->version << ".");
+  libbirch_error_msg_(header->type == array_file_type<T>::value, path <<
+      " has the wrong element type.");
+  libbirch_error_msg_(header->ndims == D, path << " has " <<
+      header->ndims << " dimensions, but " << D << " are required.");
+  libbirch_error_msg_(header->offset % 64 == 0 &&
+      header->offset >= sizeof(ArrayFileHeader) + 2*D*sizeof(int64_t) &&
+      header->offset <= bytes, path << " has an invalid header.");
+
+  /* shape, checking that all elements are within the file; the lengths and
+   * strides are untrusted, so the size and extent are checked for overflow
+   * before they are compared to the size of the file */
+  auto lengths = (const int64_t*)((const char*)mapping +
+      sizeof(ArrayFileHeader));
+  auto strides = lengths + D;
+  static const int64_t max = std::numeric_limits<int64_t>::max();
+  int64_t size = 1, extent = 1;
+  for (int i = 0; i < D; ++i) {
+    libbirch_error_msg_(lengths[i] >= 0 && strides[i] >= 0, path <<
+        " has an invalid shape.");
+    libbirch_error_msg_(lengths[i] == 0 || size <= max/lengths[i], path <<
+        " has an invalid shape.");
+    size *= lengths[i];
+    if (lengths[i] > 0) {
+      libbirch_error_msg_(strides[i] == 0 ||
+          lengths[i] - 1 <= (max - extent)/strides[i], path <<
+          " has an invalid shape.");
+      extent += (lengths[i] - 1)*strides[i];
+    }
+  }
+  auto shape = array_file_shape<D>::make(lengths, strides);
+  if (size == 0) {
+    ::munmap(mapping, bytes);
+    return Array<T,shape_type>(shape.compact());
+  }
+  int64_t capacity = (bytes - header->offset)/sizeof(T);
+  libbirch_error_msg_(extent <= capacity, path << " is truncated.");
+
+  auto buffer = new (libbirch::allocate(sizeof(Buffer<T>))) Buffer<T>(
+      capacity, mapping, bytes, header->offset);
+  return Array<T,shape_type>(shape, buffer);
+}
+
+/**
+ * Save an array to a binary array file.
+ *
+ * @ingroup libbirch
+ *
+ * @tparam T Value type.
+ * @tparam F Shape type.
+ *
+ * @param path Path of the file.
+ * @param x The array.
+ *
+ * The elements are written contiguously, in row-major order.
+ */
+template<class T, class F>
+void save_array(const std::string& path, const Array<T,F>& x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  libbirch::abort("binary array files are little-endian, and cannot be "
+      "saved on this big-endian platform");
+#endif
+  static const int D = F::count();
+  static_assert(1 <= D && D <= 2, "can only save vectors and matrices");
+
+  ArrayFileHeader header;
+  std::memcpy(header.magic, "BIRCHARR", 8);
+  header.version = 1;
+  header.type = array_file_type<T>::value;
+  header.ndims = D;
+  header.offset = (sizeof(ArrayFileHeader) + 2*D*sizeof(int64_t) + 63)/64*64;
+
+  /* lengths and strides, compact in row-major order */
+  int64_t dims[2*D];
+  array_file_dims<D>::make(x, dims);
+  char padding[64] = {0};
+  size_t npadding = header.offset - sizeof(header) - sizeof(dims);
+
+  auto f = ::fopen(path.c_str(), "w");
+  libbirch_error_msg_(f, "could not open file " << path << ".");
+  bool ok = ::fwrite(&header, sizeof(header), 1, f) == 1 &&
+      ::fwrite(dims, sizeof(dims), 1, f) == 1 &&
+      ::fwrite(padding, 1, npadding, f) == npadding;
+
+  /* elements, gathered into chunks in case the array is strided */
+  static const size_t chunk = 1024;
+  T values[chunk];
+  size_t n = 0;
+  if (x.size() > 0) {
+    x.pin();
+    for (auto iter = x.begin(); ok && iter != x.end(); ++iter) {
+      values[n++] = *iter;
+      if (n == chunk) {
+        ok = ::fwrite(values, sizeof(T), n, f) == n;
+        n = 0;
+      }
+    }
+    x.unpin();
+  }
+  if (ok && n > 0) {
+    ok = ::fwrite(values, sizeof(T), n, f) == n;
+  }
+  ok = (::fclose(f) == 0) && ok;
+  libbirch_error_msg_(ok, "could not write file " << path << ".");
+}
+}
@@ -0,0 +1,98 @@
+/**
+ * @file
+ */
+#include "libbirch/AsyncFile.hpp"
+
+#include "libbirch/assert.hpp"
+#include "libbirch/stacktrace.hpp"
+
+libbirch::AsyncFile::AsyncFile(FILE* file, const size_t capacity) :
+    file(file),
+    capacity(std::max(capacity, size_t(1))),
+    closing(false),
+    ok(true),
+    thread(&AsyncFile::run, this) {
+  //
+}
+
+bool libbirch::AsyncFile::push(const char* data, const size_t size) {
+  std::unique_lock<std::mutex> guard(mutex);
+  removed.wait(guard, [&]() { return chunks.size() < capacity; });
+  if (ok) {
+    chunks.emplace_back(data, size);
+    added.notify_one();
+  }
+  return ok;
+}
+
+bool libbirch::AsyncFile::close() {
+  std::unique_lock<std::mutex> guard(mutex);
+  closing = true;
+  added.notify_one();
+  guard.unlock();
+  thread.join();
+  ok = (::fclose(file) == 0) && ok;
+  return ok;
+}
+
+void libbirch::AsyncFile::run() {
+  std::unique_lock<std::mutex> guard(mutex);
+  while (true) {
+    added.wait(guard, [&]() { return !chunks.empty() || closing; });
+    if (chunks.empty()) {
+      break;
+    }
+
+    /* write without holding the lock, so that the calling thread may queue
+     * further chunks meanwhile */
+    auto chunk = std::move(chunks.front());
+    chunks.pop_front();
+    removed.notify_one();
+    guard.unlock();
+    bool written = ::fwrite(chunk.data(), 1, chunk.size(), file) ==
+        chunk.size();
+    guard.lock();
+    ok = ok && written;
+  }
+}
+
+/*
+ * Callbacks for the custom stream.
+ */
+static ssize_t async_file_write(void* cookie, const char* data, size_t size) {
+  auto f = static_cast<libbirch::AsyncFile*>(cookie);
+  return f->push(data, size) ? ssize_t(size) : -1;
+}
+
+static int async_file_close(void* cookie) {
+  auto f = static_cast<libbirch::AsyncFile*>(cookie);
+  bool ok = f->close();
+  delete f;
+  return ok ? 0 : -1;
+}
+
+#ifdef __linux__
+FILE* libbirch::async_file(FILE* file, const size_t capacity) {
+  cookie_io_functions_t functions;
+  functions.read = nullptr;
+  functions.write = async_file_write;
+  functions.seek = nullptr;
+  functions.close = async_file_close;
+  auto f = new AsyncFile(file, capacity);
+  auto result = ::fopencookie(f, "w", functions);
+  libbirch_error_msg_(result, "could not create output stream.");
+  return result;
+}
+#else
+static int async_file_write_bsd(void* cookie, const char* data, int size) {
+  return int(async_file_write(cookie, data, size_t(size)));
+}
+
+FILE* libbirch::async_file(FILE* file, const size_t capacity) {
+  auto f = new AsyncFile(file, capacity);
+  auto result = ::funopen(f, nullptr, async_file_write_bsd, nullptr,
+      async_file_close);
+  libbirch_error_msg_(result, "could not create output stream.");
+  return result;
+}
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+
+#include <deque>
+
+namespace libbirch {
+/**
+ * Output file written by a background thread.
+ *
+ * @ingroup libbirch
+ *
+ * The calling thread hands chunks of output to a bounded queue, and a
+ * dedicated thread writes them to the underlying file, so that the calling
+ * thread does not wait on the file system. When the queue is full, the
+ * calling thread blocks until there is space, so that memory use is bounded
+ * when output is produced faster than it can be written.
+ *
+ * The background thread only ever writes bytes to the file; it never runs
+ * code that touches objects, so that the per-thread state of the runtime,
+ * which is indexed by thread number, is not shared with the calling thread.
+ */
+class AsyncFile {
+public:
+  /**
+   * Constructor.
+   *
+   * @param file Underlying file, open for writing.
+   * @param capacity Maximum number of chunks in the queue.
+   */
+  AsyncFile(FILE* file, const size_t capacity);
+
+  /**
+   * Queue a chunk for writing, blocking while the queue is full.
+   *
+   * @param data Data.
+   * @param size Size of the data, in bytes.
+   *
+   * @return False if an earlier write has failed, true otherwise.
+   */
+  bool push(const char* data, const size_t size);
+
+  /**
+   * Wait until all chunks have been written, then stop the background
+   * thread and close the underlying file.
+   *
+   * @return Were all writes successful?
+   */
+  bool close();
+
+private:
+  /**
+   * Body of the background thread.
+   */
+  void run();
+
+  /**
+   * Underlying file.
+   */
+  FILE* file;
+
+  /**
+   * Maximum number of chunks in the queue.
+   */
+  size_t capacity;
+
+  /**
+   * Chunks waiting to be written.
+   */
+  std::deque<std::string> chunks;
+
+  /**
+   * Mutex for the queue and flags.
+   */
+  std::mutex mutex;
+
+  /**
+   * Signalled when a chunk is added or the file is closing.
+   */
+  std::condition_variable added;
+
+  /**
+   * Signalled when a chunk is removed.
+   */
+  std::condition_variable removed;
+
+  /**
+   * Is the file closing?
+   */
+  bool closing;
+
+  /**
+   * Have all writes so far succeeded?
+   */
+  bool ok;
+
+  /**
+   * Background thread.
+   */
+  std::thread thread;
+};
+
+/**
+ * Wrap an output file so that it is written by a background thread.
+ *
+ * @ingroup libbirch
+ *
+ * @param file Underlying file, open for writing.
+ * @param capacity Maximum number of chunks in the queue. Each chunk is the
+ * content of one flush of the stdio buffer of the returned file.
+ *
+ * @return A file that may be used in place of @p file. Closing it closes
+ * @p file, after all output has been written.
+ */
+FILE* async_file(FILE* file, const size_t capacity);
+}
@@ -3,23 +3,27 @@
  */
 #pragma once
 
+#include <atomic>
+
 namespace libbirch {
 /**
  * Atomic value.
  *
  * @tparam Value type.
  *
- * The implementation uses OpenMP atomics as opposed to std::atomic. The
- * advantage of this is ensured memory model consistency and the organic
- * disabling of atomics when OpenMP, and thus multithreading, is
- * disabled. The disadvantage is that OpenMP atomics do not support
- * compare-and-swap/compare-and-exchange, only swap/exchange, which requires
- * some clunkier client code, especially for read-write locks.
+ * The implementation uses std::atomic, with explicit memory orders. The
+ * defaults suit reference counts: increments are relaxed, as a thread can
+ * only increment a count for an object that it already holds; decrements
+ * that capture the new value, in order to check whether it is zero, are
+ * acquire-release, so that all writes to an object happen before it is
+ * destroyed; loads are acquire and stores release. Locks that rely on the
+ * order of operations on two different atomics pass
+ * `std::memory_order_seq_cst` instead.
  *
  * Atomic provides the default constructor, copy and move constructors, copy
- * and move assignment operators, in order to be trivially copyable and so
- * a mappable type for the purposes of OpenMP. These constructors and
- * operators *do not* behave atomically, however.
+ * and move assignment operators, in order to be copyable along with the
+ * objects that contain it. These constructors and operators *do not* behave
+ * atomically, however.
  */
 template<class T>
 class Atomic {
@@ -38,92 +42,113 @@ public:
     init(value);
   }
 
+  /**
+   * Copy constructor.
+   */
+  Atomic(const Atomic& o) {
+    init(o.value.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * Copy assignment.
+   */
+  Atomic& operator=(const Atomic& o) {
+    init(o.value.load(std::memory_order_relaxed));
+    return *this;
+  }
+
   /**
    * Initialize the value, not atomically.
    */
   void init(const T& value) {
-    this->value = value;
+    this->value.store(value, std::memory_order_relaxed);
   }
 
   /**
    * Load the value, atomically.
    */
-  T load() const {
-    T value;
-    #pragma omp atomic read
-    value = this->value;
-
-    return value;
+  T load(const std::memory_order order = std::memory_order_acquire) const {
+    return value.load(order);
   }
 
   /**
    * Store the value, atomically.
    */
-  void store(const T& value) {
-    #pragma omp atomic write
-    this->value = value;
+  void store(const T& value,
+      const std::memory_order order = std::memory_order_release) {
+    this->value.store(value, order);
   }
 
   /**
    * Exchange the value with another, atomically.
    *
    * @param value New value.
+   * @param order Memory order.
    *
    * @return Old value.
    */
-  T exchange(const T& value) {
-    T old;
-    #pragma omp atomic capture
-    {
-      old = this->value;
-      this->value = value;
-    }
-    return old;
+  T exchange(const T& value,
+      const std::memory_order order = std::memory_order_acq_rel) {
+    return this->value.exchange(value, order);
+  }
+
+  /**
+   * Exchange the value with another, atomically, if it is equal to an
+   * expected value.
+   *
+   * @param expected Expected value.
+   * @param value New value.
+   * @param order Memory order.
+   *
+   * @return True if the value was equal to @p expected, and so was
+   * replaced by @p value.
+   */
+  bool compareExchange(T expected, const T& value,
+      const std::memory_order order = std::memory_order_acq_rel) {
+    return this->value.compare_exchange_strong(expected, value, order);
   }
 
   /**
    * Increment the value by one, atomically, but without capturing the
    * current value.
    */
-  void increment() {
-    #pragma omp atomic update
-    ++value;
+  void increment(const std::memory_order order = std::memory_order_relaxed) {
+    value.fetch_add(1, order);
   }
 
   /**
    * Increment the value by two, atomically, but without capturing the
    * current value.
    */
-  void doubleIncrement() {
-    #pragma omp atomic update
-    value += 2;
+  void doubleIncrement(
+      const std::memory_order order = std::memory_order_relaxed) {
+    value.fetch_add(2, order);
   }
 
   /**
    * Decrement the value by one, atomically, but without capturing the
    * current value.
    */
-  void decrement() {
-    #pragma omp atomic update
-    --value;
+  void decrement(const std::memory_order order = std::memory_order_release) {
+    value.fetch_sub(1, order);
   }
 
   /**
    * Decrement the value by two, atomically, but without capturing the
    * current value.
    */
-  void doubleDecrement() {
-    #pragma omp atomic update
-    value -= 2;
+  void doubleDecrement(
+      const std::memory_order order = std::memory_order_release) {
+    value.fetch_sub(2, order);
   }
 
   /**
    * Add to the value, atomically, but without capturing the current value.
    */
   template<class U>
-  void add(const U& value) {
-    #pragma omp atomic update
-    this->value += value;
+  void add(const U& value,
+      const std::memory_order order = std::memory_order_relaxed) {
+    this->value.fetch_add(value, order);
   }
 
   /**
@@ -131,65 +156,73 @@ public:
    * value.
    */
   template<class U>
-  void subtract(const U& value) {
-    #pragma omp atomic update
-    this->value -= value;
+  void subtract(const U& value,
+      const std::memory_order order = std::memory_order_release) {
+    this->value.fetch_sub(value, order);
   }
 
+  /**
+   * Add to the value, atomically, capturing the old value.
+   *
+   * @return Old value.
+   */
   template<class U>
-  T operator+=(const U& value) {
-    T result;
-    #pragma omp atomic capture
-    result = this->value += value;
+  T fetchAdd(const U& value,
+      const std::memory_order order = std::memory_order_acq_rel) {
+    return this->value.fetch_add(value, order);
+  }
 
-    return result;
+  /**
+   * Subtract from the value, atomically, capturing the old value.
+   *
+   * @return Old value.
+   */
+  template<class U>
+  T fetchSub(const U& value,
+      const std::memory_order order = std::memory_order_acq_rel) {
+    return this->value.fetch_sub(value, order);
   }
 
   template<class U>
-  T operator-=(const U& value) {
-    T result;
-    #pragma omp atomic capture
-    result = this->value -= value;
+  T operator+=(const U& value) {
+    return fetchAdd(value) + value;
+  }
 
-    return result;
+  template<class U>
+  T operator-=(const U& value) {
+    return fetchSub(value) - value;
   }
 
   T operator++() {
-    T value;
-    #pragma omp atomic capture
-    value = ++this->value;
-
-    return value;
+    return fetchAdd(1) + 1;
   }
 
   T operator++(int) {
-    T value;
-    #pragma omp atomic capture
-    value = this->value++;
-
-    return value;
+    return fetchAdd(1);
   }
 
   T operator--() {
-    T value;
-    #pragma omp atomic capture
-    value = --this->value;
-
-    return value;
+    return fetchSub(1) - 1;
   }
 
   T operator--(int) {
-    T value;
-    #pragma omp atomic capture
-    value = this->value--;
+    return fetchSub(1);
+  }
 
-    return value;
+  /**
+   * Address of the value, for system calls that wait on it, such as
+   * futex. Any access through this is not atomic.
+   */
+  T* address() {
+    static_assert(sizeof(std::atomic<T>) == sizeof(T),
+        "std::atomic<T> must have the same representation as T");
+    return reinterpret_cast<T*>(&value);
   }
 
 private:
   /**
    * Value.
    */
-  T value;
+  std::atomic<T> value;
 };
 }
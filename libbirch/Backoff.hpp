@@ -0,0 +1,156 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+#include "libbirch/Atomic.hpp"
+
+namespace libbirch {
+/**
+ * Backoff for threads waiting on a lock.
+ *
+ * @ingroup libbirch
+ *
+ * Each call to wait() waits a little longer than the last: first by
+ * pausing the processor an exponentially increasing number of times, then
+ * by yielding to other threads, and finally by sleeping until woken. This
+ * keeps the latency low when a lock is held only briefly, but stops waiting
+ * threads from burning entire time slices when the thread holding the lock
+ * has been preempted, as when there are more threads than cores.
+ *
+ * A thread that sleeps must be woken with wake() on the same word, so before
+ * the first call to wait() for which sleeping() is true, the caller should
+ * record, in the word itself, that there are sleeping threads. Sleeping uses
+ * a futex on Linux; on other platforms it is a short sleep, and wake() does
+ * nothing.
+ */
+class Backoff {
+public:
+  /**
+   * Constructor.
+   */
+  Backoff();
+
+  /**
+   * Will the next call to wait() sleep?
+   */
+  bool sleeping() const;
+
+  /**
+   * Wait.
+   *
+   * @param word Word on which to sleep.
+   * @param value Value of the word; the thread only sleeps while the word
+   * has this value.
+   */
+  void wait(Atomic<unsigned>& word, const unsigned value);
+
+  /**
+   * Wait, without sleeping. Once the pauses are exhausted, this always
+   * yields.
+   */
+  void wait();
+
+  /**
+   * Wake one thread sleeping on a word.
+   */
+  static void wakeOne(Atomic<unsigned>& word);
+
+  /**
+   * Wake all threads sleeping on a word.
+   */
+  static void wakeAll(Atomic<unsigned>& word);
+
+private:
+  /**
+   * Pause the processor.
+   */
+  static void pause();
+
+  /**
+   * Wake threads sleeping on a word.
+   */
+  static void wake(Atomic<unsigned>& word, const int n);
+
+  /**
+   * Number of calls to wait() that pause, the last pausing
+   * \f$2^{\mathrm{npause} - 1}\f$ times.
+   */
+  static const unsigned npause = 7;
+
+  /**
+   * Number of calls to wait() that pause or yield.
+   */
+  static const unsigned nyield = npause + 16;
+
+  /**
+   * Number of calls to wait() so far.
+   */
+  unsigned n;
+};
+}
+
+inline libbirch::Backoff::Backoff() :
+    n(0) {
+  //
+}
+
+inline bool libbirch::Backoff::sleeping() const {
+  return n >= nyield;
+}
+
+inline void libbirch::Backoff::wait(Atomic<unsigned>& word,
+    const unsigned value) {
+  if (n < npause) {
+    for (unsigned i = 0; i < (1u << n); ++i) {
+      pause();
+    }
+    ++n;
+  } else if (n < nyield) {
+    sched_yield();
+    ++n;
+  } else {
+    #ifdef __linux__
+    syscall(SYS_futex, word.address(), FUTEX_WAIT_PRIVATE, value, nullptr,
+        nullptr, 0);
+    #else
+    struct timespec ts = { 0, 50000 };
+    nanosleep(&ts, nullptr);
+    #endif
+  }
+}
+
+inline void libbirch::Backoff::wait() {
+  if (n < npause) {
+    for (unsigned i = 0; i < (1u << n); ++i) {
+      pause();
+    }
+    ++n;
+  } else {
+    sched_yield();
+  }
+}
+
+inline void libbirch::Backoff::wakeOne(Atomic<unsigned>& word) {
+  wake(word, 1);
+}
+
+inline void libbirch::Backoff::wakeAll(Atomic<unsigned>& word) {
+  wake(word, std::numeric_limits<int>::max());
+}
+
+inline void libbirch::Backoff::pause() {
+  #if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+  #elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+  #endif
+}
+
+inline void libbirch::Backoff::wake(Atomic<unsigned>& word, const int n) {
+  #ifdef __linux__
+  syscall(SYS_futex, word.address(), FUTEX_WAKE_PRIVATE, n, nullptr,
+      nullptr, 0);
+  #endif
+}
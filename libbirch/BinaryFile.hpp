@@ -0,0 +1,187 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+#include "libbirch/assert.hpp"
+#include "libbirch/stacktrace.hpp"
+#include "libbirch/Array.hpp"
+
+namespace libbirch {
+/**
+ * Tag of a value in a binary file, written as its first byte.
+ *
+ * @ingroup libbirch
+ *
+ * A binary file consists of a BinaryFileHeader, followed by a single value.
+ * Scalars follow their tag directly: integers and reals as 64-bit, strings
+ * as a 64-bit length and then their bytes. An object is a sequence of names
+ * (each a tagged string) and values, and an array is a sequence of values,
+ * each closed by `BINARY_END`. Vectors and matrices of a single type
+ * are written densely, as a 64-bit length (for a matrix, the number of rows
+ * then columns) followed by the elements in row-major order. A record is a
+ * 64-bit length in bytes followed by a value, so that a reader may skip it.
+ * All values are little-endian.
+ */
+enum BinaryTag : uint8_t {
+  BINARY_NIL = 0,
+  BINARY_FALSE = 1,
+  BINARY_TRUE = 2,
+  BINARY_INTEGER = 3,
+  BINARY_REAL = 4,
+  BINARY_STRING = 5,
+  BINARY_OBJECT = 6,
+  BINARY_ARRAY = 7,
+  BINARY_END = 8,
+  BINARY_BOOLEAN_VECTOR = 9,
+  BINARY_INTEGER_VECTOR = 10,
+  BINARY_REAL_VECTOR = 11,
+  BINARY_BOOLEAN_MATRIX = 12,
+  BINARY_INTEGER_MATRIX = 13,
+  BINARY_REAL_MATRIX = 14,
+  BINARY_RECORD = 15
+};
+
+/**
+ * Header of a binary file.
+ *
+ * @ingroup libbirch
+ */
+struct BinaryFileHeader {
+  /**
+   * Magic number, the characters `BIRCHBIN`.
+   */
+  char magic[8];
+
+  /**
+   * Version of the format, currently 1.
+   */
+  uint32_t version;
+
+  /**
+   * Reserved, currently zero.
+   */
+  uint32_t reserved;
+};
+
+/**
+ * Append a scalar to pending output.
+ *
+ * @ingroup libbirch
+ */
+template<class T>
+void binary_put(std::string& out, const T& x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  libbirch::abort("binary files are little-endian, and cannot be written "
+      "on this big-endian platform");
+#endif
+  out.append(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+/**
+ * Append a string to pending output, preceded by its length.
+ *
+ * @ingroup libbirch
+ */
+inline void binary_put(std::string& out, const std::string& x) {
+  binary_put(out, int64_t(x.size()));
+  out.append(x);
+}
+
+/**
+ * Append the elements of an array to pending output, in row-major order.
+ *
+ * @ingroup libbirch
+ */
+template<class T, class F>
+void binary_put(std::string& out, const Array<T,F>& x) {
+  auto n = x.size();
+  if (n > 0) {
+    auto from = out.size();
+    out.resize(from + n*sizeof(T));
+    auto dst = reinterpret_cast<T*>(&out[from]);
+    x.pin();
+    std::copy(x.begin(), x.end(), dst);
+    x.unpin();
+  }
+}
+
+/**
+ * Append the header of a binary file to pending output.
+ *
+ * @ingroup libbirch
+ */
+inline void binary_put_header(std::string& out) {
+  BinaryFileHeader header;
+  std::memcpy(header.magic, "BIRCHBIN", 8);
+  header.version = 1;
+  header.reserved = 0;
+  binary_put(out, header);
+}
+
+/**
+ * Read bytes from a file, aborting if there are not enough.
+ *
+ * @ingroup libbirch
+ */
+inline void binary_get(FILE* file, void* x, const size_t bytes) {
+  libbirch_error_msg_(bytes == 0 || std::fread(x, 1, bytes, file) == bytes,
+      "unexpected end of binary file.");
+}
+
+/**
+ * Read a scalar from a file.
+ *
+ * @ingroup libbirch
+ */
+template<class T>
+T binary_get(FILE* file) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  libbirch::abort("binary files are little-endian, and cannot be read on "
+      "this big-endian platform");
+#endif
+  T x;
+  binary_get(file, &x, sizeof(T));
+  return x;
+}
+
+/**
+ * Read a string from a file, preceded by its length.
+ *
+ * @ingroup libbirch
+ */
+inline std::string binary_get_string(FILE* file) {
+  auto n = binary_get<int64_t>(file);
+  libbirch_error_msg_(n >= 0, "invalid string in binary file.");
+  std::string x(n, '\0');
+  binary_get(file, &x[0], n);
+  return x;
+}
+
+/**
+ * Read the elements of a newly-allocated array from a file, in row-major
+ * order.
+ *
+ * @ingroup libbirch
+ */
+template<class T, class F>
+void binary_get(FILE* file, Array<T,F>& x) {
+  if (x.size() > 0) {
+    binary_get(file, &*x.begin(), x.size()*sizeof(T));
+  }
+}
+
+/**
+ * Read and validate the header of a binary file.
+ *
+ * @ingroup libbirch
+ */
+inline void binary_get_header(FILE* file) {
+  auto header = binary_get<BinaryFileHeader>(file);
+  libbirch_error_msg_(std::memcmp(header.magic, "BIRCHBIN", 8) == 0,
+      "not a binary file.");
+  libbirch_error_msg_(header.version == 1, "binary file has unsupported "
+      "version " << header.version << ".");
+}
+}
@@ -15,6 +15,10 @@ namespace libbirch {
  * the one allocation. They do not inherit from Countable, as their reference
  * counting semantics are simpler.
  *
+ * A buffer may alternatively wrap the read-only contents of a memory-mapped
+ * file, in which case only the bookkeeping variables are allocated, and the
+ * contents are unmapped, rather than deallocated, after last use.
+ *
  * @ingroup libbirch
  */
 template<class T>
@@ -27,8 +31,33 @@ public:
 
   /**
    * Constructor.
+   *
+   * @param capacity Number of elements for which space is allocated.
+   */
+  Buffer(const int64_t capacity);
+
+  /**
+   * Constructor for a buffer that wraps memory-mapped contents.
+   *
+   * @param capacity Number of elements in the mapping.
+   * @param mapping Start of the mapping, as returned by `mmap()`.
+   * @param bytes Length of the mapping, in bytes.
+   * @param offset Offset of the first element from the start of the
+   * mapping, in bytes.
+   */
+  Buffer(const int64_t capacity, void* mapping, const size_t bytes,
+      const size_t offset);
+
+  /**
+   * Does this buffer wrap memory-mapped contents? Such contents are
+   * read-only.
    */
-  Buffer();
+  bool isMapped() const;
+
+  /**
+   * Unmap memory-mapped contents.
+   */
+  void unmap();
 
   /**
    * Increment the usage count.
@@ -63,12 +92,35 @@ public:
    */
   static size_t size(const int64_t n);
 
+  /**
+   * Number of elements for which space is allocated. This may exceed the
+   * number of elements in use, so that one-dimensional arrays can be
+   * enlarged in place with amortized constant cost.
+   */
+  int64_t capacity;
+
   /**
    * Id of the thread that allocated the buffer.
    */
   int tid;
 
 private:
+  /**
+   * Start of the mapping, if the contents are memory mapped, otherwise
+   * `nullptr`.
+   */
+  char* mapping;
+
+  /**
+   * Length of the mapping, in bytes.
+   */
+  size_t mappingBytes;
+
+  /**
+   * Offset of the first element from the start of the mapping, in bytes.
+   */
+  size_t mappingOffset;
+
   /**
    * Use count (the number of arrays sharing this buffer).
    */
@@ -83,12 +135,40 @@ private:
 }
 
 template<class T>
-libbirch::Buffer<T>::Buffer() :
+libbirch::Buffer<T>::Buffer(const int64_t capacity) :
+    capacity(capacity),
     tid(get_thread_num()),
+    mapping(nullptr),
+    mappingBytes(0),
+    mappingOffset(0),
     useCount(1) {
   //
 }
 
+template<class T>
+libbirch::Buffer<T>::Buffer(const int64_t capacity, void* mapping,
+    const size_t bytes, const size_t offset) :
+    capacity(capacity),
+    tid(get_thread_num()),
+    mapping((char*)mapping),
+    mappingBytes(bytes),
+    mappingOffset(offset),
+    useCount(1) {
+  assert(mapping);
+}
+
+template<class T>
+bool libbirch::Buffer<T>::isMapped() const {
+  return mapping;
+}
+
+template<class T>
+void libbirch::Buffer<T>::unmap() {
+  assert(mapping);
+  munmap(mapping, mappingBytes);
+  mapping = nullptr;
+}
+
 template<class T>
 void libbirch::Buffer<T>::incUsage() {
   useCount.increment();
@@ -107,12 +187,12 @@ unsigned libbirch::Buffer<T>::numUsage() const {
 
 template<class T>
 T* libbirch::Buffer<T>::buf() {
-  return (T*)&first;
+  return mapping ? (T*)(mapping + mappingOffset) : (T*)&first;
 }
 
 template<class T>
 const T* libbirch::Buffer<T>::buf() const {
-  return (const T*)&first;
+  return mapping ? (const T*)(mapping + mappingOffset) : (const T*)&first;
 }
 
 template<class T>
@@ -52,10 +52,12 @@ public:
   }
 
   /**
-   * New operator.
+   * New operator. Objects are allocated with allocate_recycled(), as most
+   * are small, and many are short lived, such as the fiber states, events
+   * and records created for each particle at each time step.
    */
   void* operator new(std::size_t size) {
-    auto ptr = (Counted*)allocate(size);
+    auto ptr = (Counted*)allocate_recycled(size);
     ptr->size = (unsigned)size;
     ptr->tid = get_thread_num();
     return ptr;
@@ -169,7 +171,7 @@ protected:
     assert(sharedCount.load() == 0u);
     assert(weakCount.load() == 0u);
     assert(memoCount.load() == 0u);
-    libbirch::deallocate(this, size, tid);
+    libbirch::deallocate_recycled(this, size);
   }
 
   /**
@@ -201,9 +203,8 @@ protected:
   unsigned size;
 
   /**
-   * Id of the thread associated with the object. This is used to return the
-   * allocation to the correct pool after use, even when returned by a
-   * different thread.
+   * Id of the thread that allocated the object. On deallocation, the
+   * allocation is recycled by the thread that releases it instead.
    */
   int tid;
 };
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "libbirch/Atomic.hpp"
+#include "libbirch/Backoff.hpp"
 
 namespace libbirch {
 /**
@@ -39,11 +40,18 @@ private:
    * Number of threads in critical region.
    */
   Atomic<unsigned> ninternal;
+
+  /**
+   * Number of threads sleeping until there are no threads in the critical
+   * region.
+   */
+  Atomic<unsigned> nsleeping;
 };
 }
 
 inline libbirch::EntryExitLock::EntryExitLock() :
-    ninternal(0) {
+    ninternal(0u),
+    nsleeping(0u) {
   //
 }
 
@@ -52,9 +60,27 @@ inline void libbirch::EntryExitLock::enter() {
 }
 
 inline void libbirch::EntryExitLock::exit() {
-  if (--ninternal == 0) {
-    return;
+  if (ninternal.fetchSub(1u, std::memory_order_seq_cst) == 1u) {
+    if (nsleeping.load(std::memory_order_seq_cst) != 0u) {
+      Backoff::wakeAll(ninternal);
+    }
   } else {
-    while (ninternal.load() != 0);  // spin until the entry gate is open
+    /* wait until the entry gate is open */
+    Backoff backoff;
+    unsigned n;
+    while ((n = ninternal.load()) != 0u) {
+      if (backoff.sleeping()) {
+        /* record that this thread is sleeping before checking again, so
+         * that the last thread to exit sees it and wakes it */
+        nsleeping.increment(std::memory_order_seq_cst);
+        n = ninternal.load(std::memory_order_seq_cst);
+        if (n != 0u) {
+          backoff.wait(ninternal, n);
+        }
+        nsleeping.decrement();
+      } else {
+        backoff.wait(ninternal, n);
+      }
+    }
   }
 }
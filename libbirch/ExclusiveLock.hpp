@@ -5,12 +5,16 @@
 
 #include "libbirch/external.hpp"
 #include "libbirch/Atomic.hpp"
+#include "libbirch/Backoff.hpp"
 
 namespace libbirch {
 /**
  * Lock with exclusive use semantics.
  *
  * @ingroup libbirch
+ *
+ * Threads waiting for the lock back off, and eventually sleep, according to
+ * Backoff.
  */
 class ExclusiveLock {
 public:
@@ -36,27 +40,41 @@ public:
 
 private:
   /**
-   * Lock.
+   * Lock. This is 0 when free, 1 when held, and 2 when held and other
+   * threads may be sleeping on it.
    */
-  Atomic<bool> lock;
+  Atomic<unsigned> lock;
 };
 }
 
 inline libbirch::ExclusiveLock::ExclusiveLock() :
-    lock(false) {
+    lock(0u) {
   //
 }
 
 inline libbirch::ExclusiveLock::ExclusiveLock(const ExclusiveLock& o) :
-    lock(false) {
+    lock(0u) {
   //
 }
 
 inline void libbirch::ExclusiveLock::set() {
-  /* spin, setting the lock true until its old value comes back false */
-  while (lock.exchange(true));
+  /* set the lock until its old value comes back 0; once other threads may
+   * be sleeping on it, always set it to 2, so that whichever thread obtains
+   * it will wake them on release, even if this thread had overwritten a 2
+   * with a 1 earlier */
+  Backoff backoff;
+  unsigned mark = 1u;
+  unsigned old;
+  while ((old = lock.exchange(mark)) != 0u) {
+    if (old == 2u || backoff.sleeping()) {
+      mark = 2u;
+    }
+    backoff.wait(lock, mark);
+  }
 }
 
 inline void libbirch::ExclusiveLock::unset() {
-  lock.store(false);
+  if (lock.exchange(0u) == 2u) {
+    Backoff::wakeOne(lock);
+  }
 }
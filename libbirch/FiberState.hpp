@@ -12,6 +12,12 @@ namespace libbirch {
  * @ingroup libbirch
  *
  * @tparam YieldType Yield type.
+ *
+ * A new fiber state is created each time that a fiber is called, and
+ * destroyed when it finishes; for a model, this is once per particle per
+ * time step. As for all objects, the memory of those previously destroyed on
+ * the same thread is reused by allocate_recycled(), rather than returned to
+ * the heap.
  */
 template<class YieldType>
 class FiberState: public Any {
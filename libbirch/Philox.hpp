@@ -0,0 +1,151 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+
+namespace libbirch {
+/**
+ * Philox4x32-10 counter-based pseudorandom number generator.
+ *
+ * @ingroup libbirch
+ *
+ * The generator is a bijection, keyed by the seed, applied to a 128-bit
+ * counter, so that any number of independent streams can be obtained, and
+ * any position in any stream reached directly, without generating those
+ * before it. Here the counter consists of a 32-bit block counter, a 32-bit
+ * step, and a 64-bit particle index, so that the draws for a particle at a
+ * time step depend only on the seed, the particle index, the time step and
+ * the number of draws so far, and not on the thread that makes them. Each
+ * block gives four 32-bit outputs, used in pairs as 64-bit results.
+ *
+ * This satisfies the requirements of a UniformRandomBitGenerator, so may be
+ * used with the standard library distributions.
+ *
+ * Salmon, J. K., M. A. Moraes, R. O. Dror and D. E. Shaw (2011). Parallel
+ * random numbers: As easy as 1, 2, 3. In Proceedings of the International
+ * Conference for High Performance Computing, Networking, Storage and
+ * Analysis.
+ */
+class Philox {
+public:
+  using result_type = uint64_t;
+
+  /**
+   * Constructor.
+   *
+   * @param seed Seed.
+   */
+  explicit Philox(const uint64_t seed = 0);
+
+  /**
+   * Set the seed, and restart the current stream.
+   */
+  void seed(const uint64_t seed);
+
+  /**
+   * Select a stream, starting from its beginning.
+   *
+   * @param particle Particle index.
+   * @param step Time step.
+   */
+  void stream(const uint64_t particle, const uint32_t step);
+
+  /**
+   * Next result.
+   */
+  result_type operator()();
+
+  static constexpr result_type min() {
+    return 0;
+  }
+
+  static constexpr result_type max() {
+    return ~result_type(0);
+  }
+
+  /**
+   * Apply the bijection to a block.
+   *
+   * @param key Key.
+   * @param[in,out] ctr Counter on input, output on output.
+   */
+  static void block(const uint32_t key[2], uint32_t ctr[4]);
+
+private:
+  /**
+   * Key.
+   */
+  uint32_t key[2];
+
+  /**
+   * Counter.
+   */
+  uint32_t ctr[4];
+
+  /**
+   * Output of the last block.
+   */
+  uint32_t out[4];
+
+  /**
+   * Position in the output of the last block, either 0 or 2, or 4 when a
+   * new block is required.
+   */
+  unsigned pos;
+};
+}
+
+inline libbirch::Philox::Philox(const uint64_t seed) {
+  this->seed(seed);
+  stream(0, 0);
+}
+
+inline void libbirch::Philox::seed(const uint64_t seed) {
+  key[0] = uint32_t(seed);
+  key[1] = uint32_t(seed >> 32);
+  ctr[0] = 0;
+  pos = 4;
+}
+
+inline void libbirch::Philox::stream(const uint64_t particle,
+    const uint32_t step) {
+  ctr[0] = 0;
+  ctr[1] = step;
+  ctr[2] = uint32_t(particle);
+  ctr[3] = uint32_t(particle >> 32);
+  pos = 4;
+}
+
+inline libbirch::Philox::result_type libbirch::Philox::operator()() {
+  if (pos == 4) {
+    std::copy(ctr, ctr + 4, out);
+    block(key, out);
+    ++ctr[0];
+    pos = 0;
+  }
+  auto result = (uint64_t(out[pos + 1]) << 32) | out[pos];
+  pos += 2;
+  return result;
+}
+
+inline void libbirch::Philox::block(const uint32_t key[2], uint32_t ctr[4]) {
+  static const uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  static const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round < 10; ++round) {
+    uint64_t p0 = M0*ctr[0];
+    uint64_t p1 = M1*ctr[2];
+    uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ k0;
+    uint32_t c1 = uint32_t(p1);
+    uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ k1;
+    uint32_t c3 = uint32_t(p0);
+    ctr[0] = c0;
+    ctr[1] = c1;
+    ctr[2] = c2;
+    ctr[3] = c3;
+    k0 += W0;
+    k1 += W1;
+  }
+}
@@ -4,12 +4,24 @@
 #pragma once
 
 #include "libbirch/external.hpp"
+#include "libbirch/Atomic.hpp"
+#include "libbirch/Backoff.hpp"
 
 namespace libbirch {
 /**
  * Lock allowing multiple readers but only one writer.
  *
  * @ingroup libbirch
+ *
+ * Writers have preference: once a writer is waiting, new readers wait for
+ * it to finish, so that a steady stream of readers cannot starve it. The
+ * exception is a thread that already has read use of some lock, which waits
+ * only for a writer that is in the critical region, not for one waiting to
+ * enter. This keeps read use reentrant: a thread may obtain read use of a
+ * lock for which it already has read use, as when pinning an array twice,
+ * without waiting for a writer that is itself waiting for that thread to
+ * leave. Threads waiting for the lock back off, and eventually sleep,
+ * according to Backoff.
  */
 class ReaderWriterLock {
 public:
@@ -40,7 +52,9 @@ public:
 
   /**
    * Assuming that the calling thread already has a read lock, upgrades that
-   * lock to a write lock.
+   * lock to a write lock. If another writer is waiting, the read lock is
+   * released before the write lock is obtained, so that another writer may
+   * enter the critical region in between.
    */
   void upgrade();
 
@@ -52,74 +66,182 @@ public:
 
 private:
   /**
-   * Number of readers in critical region.
+   * Number of readers in critical region, plus `entered` if there is a
+   * writer in the critical region.
    */
   Atomic<unsigned> readers;
 
   /**
-   * Is there a writer in the critical region?
+   * Is there a writer in, or waiting for, the critical region? This is 0
+   * when not, 1 when so, and 2 when so and other threads may be sleeping on
+   * it.
+   */
+  Atomic<unsigned> writer;
+
+  /**
+   * Flag added to `readers` when a writer enters the critical region.
+   */
+  static const unsigned entered = 1u << 31;
+
+  /**
+   * Number of read locks, of any ReaderWriterLock, held by the calling
+   * thread.
+   */
+  static unsigned& depth();
+
+  /**
+   * Release read use, without updating depth().
+   */
+  void leave();
+
+  /**
+   * Enter the critical region, once the write lock is obtained and any
+   * readers have left.
+   */
+  void enter();
+
+  /**
+   * Obtain the write lock, as for ExclusiveLock.
+   *
+   * @param mark0 Initial value to set, 1, or 2 if other threads may already
+   * be sleeping on it.
    */
-  Atomic<bool> writer;
+  void setWriter(const unsigned mark0);
+
+  /**
+   * Wait until there is no writer in, or waiting for, the critical region.
+   */
+  void waitWriter();
 };
 }
 
 inline libbirch::ReaderWriterLock::ReaderWriterLock() :
-    readers(0),
-    writer(false) {
+    readers(0u),
+    writer(0u) {
   //
 }
 
 inline void libbirch::ReaderWriterLock::read() {
-  readers.increment();
-  while (writer.load()) {
-    //
+  auto& n = depth();
+  if (n > 0u) {
+    /* the thread already has read use of some lock, possibly this one, for
+     * which a waiting writer may be waiting on this thread; so wait only
+     * for a writer that is in the critical region */
+    Backoff backoff;
+    while (readers.fetchAdd(1u, std::memory_order_seq_cst) & entered) {
+      leave();
+      backoff.wait();
+    }
+  } else {
+    readers.increment(std::memory_order_seq_cst);
+    while (writer.load(std::memory_order_seq_cst) != 0u) {
+      /* a writer is in, or waiting for, the critical region; back out to
+       * let it proceed, and try again once it is done */
+      leave();
+      waitWriter();
+      readers.increment(std::memory_order_seq_cst);
+    }
   }
+  ++n;
 }
 
 inline void libbirch::ReaderWriterLock::unread() {
-  readers.decrement();
+  leave();
+  --depth();
 }
 
 inline void libbirch::ReaderWriterLock::write() {
-  bool w;
-  do {
-    /* obtain the write lock */
-    while (writer.exchange(true));
-
-    /* check if there are any readers; if so release the write lock to
-     * let those readers proceed and avoid a deadlock situation, repeating
-     * from the start, otherwise proceed */
-    w = (readers.load() == 0);
-    if (!w) {
-      writer.store(false);
-    }
-  } while (!w);
+  setWriter(1u);
+
+  /* new readers now wait, but wait for any readers already in the critical
+   * region to leave */
+  enter();
 }
 
 inline void libbirch::ReaderWriterLock::unwrite() {
-  writer.store(false);
+  readers.subtract(entered, std::memory_order_seq_cst);
+  if (writer.exchange(0u) == 2u) {
+    Backoff::wakeAll(writer);
+  }
 }
 
 inline void libbirch::ReaderWriterLock::upgrade() {
-  bool w;
-  do {
-    /* obtain the write lock */
-    while (writer.exchange(true));
-
-    /* check if there are any readers other than current thread; if so
-     * release the write lock to let those readers proceed and avoid a
-     * deadlock situation, repeating from the start, otherwise proceed */
-    w = (readers.load() == 1);
-    if (!w) {
-      writer.store(false);
+  unsigned old = writer.exchange(1u, std::memory_order_seq_cst);
+  if (old == 0u) {
+    /* wait for any readers other than the current thread to leave, then
+     * exchange the current thread's read use for the critical region */
+    Backoff backoff;
+    while (!readers.compareExchange(1u, entered,
+        std::memory_order_seq_cst)) {
+      backoff.wait();
     }
-  } while (!w);
-
-  /* release the current thread's read lock */
-  readers.decrement();
+  } else {
+    /* another writer is in, or waiting for, the critical region, and may
+     * be waiting for the current thread to leave; to avoid a deadlock,
+     * release the read lock and obtain the write lock afresh, having
+     * restored any record of sleeping threads that the exchange above
+     * overwrote */
+    leave();
+    setWriter(old);
+    enter();
+  }
+  --depth();
 }
 
 inline void libbirch::ReaderWriterLock::downgrade() {
-  readers.increment();
-  writer.store(false);
+  readers.increment(std::memory_order_seq_cst);
+  ++depth();
+  unwrite();
+}
+
+inline unsigned& libbirch::ReaderWriterLock::depth() {
+  static thread_local unsigned n = 0u;
+  return n;
+}
+
+inline void libbirch::ReaderWriterLock::leave() {
+  if (readers.fetchSub(1u, std::memory_order_seq_cst) == 1u &&
+      writer.load(std::memory_order_seq_cst) != 0u) {
+    /* a writer may be sleeping until there are no readers */
+    Backoff::wakeAll(readers);
+  }
+}
+
+inline void libbirch::ReaderWriterLock::enter() {
+  Backoff backoff;
+  while (!readers.compareExchange(0u, entered, std::memory_order_seq_cst)) {
+    unsigned r = readers.load(std::memory_order_seq_cst);
+    if (r != 0u) {
+      backoff.wait(readers, r);
+    }
+  }
+}
+
+inline void libbirch::ReaderWriterLock::setWriter(const unsigned mark0) {
+  Backoff backoff;
+  unsigned mark = mark0;
+  unsigned old;
+  while ((old = writer.exchange(mark, std::memory_order_seq_cst)) != 0u) {
+    if (old == 2u || backoff.sleeping()) {
+      mark = 2u;
+    }
+    backoff.wait(writer, mark);
+  }
 }
+
+inline void libbirch::ReaderWriterLock::waitWriter() {
+  Backoff backoff;
+  while (writer.load() != 0u) {
+    if (backoff.sleeping()) {
+      /* record that this thread is sleeping, so that the writer wakes it
+       * on release; if the writer has already released, this obtains the
+       * write lock instead, so release it again */
+      if (writer.exchange(2u) == 0u) {
+        unwrite();
+        continue;
+      }
+    }
+    backoff.wait(writer, 2u);
+  }
+}
+
@@ -0,0 +1,68 @@
+/**
+ * @file
+ */
+#include "libbirch/TaskScheduler.hpp"
+
+libbirch::TaskScheduler::TaskScheduler() :
+    blocks(get_max_threads()),
+    stats(get_max_threads()) {
+  //
+}
+
+const std::vector<libbirch::TaskScheduler::Statistics>&
+    libbirch::TaskScheduler::statistics() const {
+  return stats;
+}
+
+void libbirch::TaskScheduler::reset() {
+  std::fill(stats.begin(), stats.end(), Statistics());
+}
+
+int libbirch::TaskScheduler::outer_thread_num() {
+#ifdef _OPENMP
+  for (int level = omp_get_level(); level > 0; --level) {
+    if (omp_get_team_size(level) > 1) {
+      return omp_get_ancestor_thread_num(level);
+    }
+  }
+#endif
+  return get_thread_num();
+}
+
+int64_t libbirch::TaskScheduler::pop(const int tid) {
+  auto& block = blocks[tid];
+  int64_t i = -1;
+  block.lock.set();
+  if (block.first < block.last) {
+    i = block.first++;
+  }
+  block.lock.unset();
+  return i;
+}
+
+bool libbirch::TaskScheduler::steal(const int tid) {
+  /* try each other thread in turn, starting from the next one, so that
+   * thieves spread out over victims */
+  auto nthreads = int(blocks.size());
+  for (int j = 1; j < nthreads; ++j) {
+    auto& victim = blocks[(tid + j) % nthreads];
+    int64_t first = 0, last = 0;
+    victim.lock.set();
+    if (victim.first < victim.last) {
+      last = victim.last;
+      first = victim.last - (victim.last - victim.first + 1)/2;
+      victim.last = first;
+    }
+    victim.lock.unset();
+    if (first < last) {
+      auto& block = blocks[tid];
+      block.lock.set();
+      block.first = first;
+      block.last = last;
+      block.lock.unset();
+      ++stats[tid].nsteals;
+      return true;
+    }
+  }
+  return false;
+}
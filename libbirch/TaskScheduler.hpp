@@ -0,0 +1,194 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+#include "libbirch/thread.hpp"
+#include "libbirch/ExclusiveLock.hpp"
+
+namespace libbirch {
+/**
+ * Work-stealing scheduler for independent tasks.
+ *
+ * @ingroup libbirch
+ *
+ * Tasks are identified by index. Each thread starts with a contiguous block
+ * of indices, as for a static schedule, and runs tasks from the front of it.
+ * A thread that runs out steals the back half of the remaining block of
+ * another thread. This balances the load when the cost of tasks varies
+ * widely, as for particles that are propagated a random number of times,
+ * without the overhead of a dynamic schedule that hands out one task at a
+ * time from a shared counter.
+ *
+ * The scheduler also keeps, for each thread, the time spent running tasks,
+ * the time spent in run() overall, and the number of tasks run and steals
+ * made, until reset().
+ *
+ * The scheduler is not reentrant: there is one block per thread, shared by
+ * all calls. Calls to run() from outside a parallel region are therefore
+ * serialized by a lock, so that concurrent callers, such as threads other
+ * than those of the parallel backend, wait their turn. Calls from within a
+ * parallel region, such as from a task, do not use the blocks, but run
+ * their tasks on the calling thread.
+ */
+class TaskScheduler {
+public:
+  /**
+   * Statistics for one thread.
+   */
+  struct Statistics {
+    /**
+     * Time spent running tasks, in seconds.
+     */
+    double busy = 0.0;
+
+    /**
+     * Time spent in run(), in seconds.
+     */
+    double elapsed = 0.0;
+
+    /**
+     * Number of tasks run.
+     */
+    int64_t ntasks = 0;
+
+    /**
+     * Number of successful steals.
+     */
+    int64_t nsteals = 0;
+  };
+
+  /**
+   * Constructor.
+   */
+  TaskScheduler();
+
+  /**
+   * Run tasks.
+   *
+   * @tparam F Function type.
+   *
+   * @param n Number of tasks.
+   * @param f Function, called with the index of each task, from 0 to
+   * `n - 1`.
+   *
+   * If called from within a parallel region, the tasks are run on the
+   * calling thread only.
+   */
+  template<class F>
+  void run(const int64_t n, const F& f);
+
+  /**
+   * Statistics for each thread.
+   */
+  const std::vector<Statistics>& statistics() const;
+
+  /**
+   * Reset statistics.
+   */
+  void reset();
+
+private:
+  /**
+   * Block of tasks of one thread. The owner takes tasks from the front,
+   * thieves from the back.
+   */
+  struct Block {
+    ExclusiveLock lock;
+    int64_t first;
+    int64_t last;
+
+    /**
+     * Padding to avoid false sharing between threads.
+     */
+    char padding[64];
+  };
+
+  /**
+   * Take the next task from the front of a thread's own block.
+   *
+   * @return Index of the task, or -1 if the block is empty.
+   */
+  int64_t pop(const int tid);
+
+  /**
+   * Steal the back half of another thread's block into a thread's own
+   * block.
+   *
+   * @return Was anything stolen?
+   */
+  bool steal(const int tid);
+
+  /**
+   * Number of the calling thread in the innermost active parallel region.
+   * Within a nested OpenMP parallel region, which has a team of one thread,
+   * get_thread_num() is zero for every thread, so cannot be used to index
+   * per-thread state.
+   */
+  static int outer_thread_num();
+
+  /**
+   * Block of each thread.
+   */
+  std::vector<Block> blocks;
+
+  /**
+   * Statistics of each thread.
+   */
+  std::vector<Statistics> stats;
+
+  /**
+   * Lock held by each call to run() from outside a parallel region.
+   */
+  ExclusiveLock running;
+};
+
+/**
+ * Get the task scheduler.
+ */
+TaskScheduler& task_scheduler();
+}
+
+template<class F>
+void libbirch::TaskScheduler::run(const int64_t n, const F& f) {
+  using clock = std::chrono::steady_clock;
+  auto nested = in_parallel();
+  if (!nested) {
+    running.set();
+  }
+  if (nested || get_max_threads() == 1) {
+    auto& s = stats[nested ? outer_thread_num() : 0];
+    auto start = clock::now();
+    for (int64_t i = 0; i < n; ++i) {
+      f(i);
+    }
+    auto seconds = std::chrono::duration<double>(clock::now() - start).count();
+    s.busy += seconds;
+    s.elapsed += seconds;
+    s.ntasks += n;
+  } else {
+    auto nthreads = get_max_threads();
+    for (int tid = 0; tid < nthreads; ++tid) {
+      blocks[tid].first = n*tid/nthreads;
+      blocks[tid].last = n*(tid + 1)/nthreads;
+    }
+    parallel([&](const int tid) {
+      auto& s = stats[tid];
+      auto start = clock::now();
+      do {
+        int64_t i;
+        while ((i = pop(tid)) >= 0) {
+          auto begin = clock::now();
+          f(i);
+          s.busy += std::chrono::duration<double>(clock::now() - begin).count();
+          ++s.ntasks;
+        }
+      } while (steal(tid));
+      s.elapsed += std::chrono::duration<double>(clock::now() - start).count();
+    });
+  }
+  if (!nested) {
+    running.unset();
+  }
+}
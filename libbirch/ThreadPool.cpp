@@ -0,0 +1,89 @@
+/**
+ * @file
+ */
+#include "libbirch/ThreadPool.hpp"
+
+#include "libbirch/thread.hpp"
+
+libbirch::ThreadPool::ThreadPool() :
+    job(nullptr),
+    generation(0u),
+    nbusy(0),
+    nthreads(1),
+    active(false),
+    stopping(false) {
+  auto var = std::getenv("OMP_NUM_THREADS");
+  if (var) {
+    nthreads = std::atoi(var);
+  } else {
+    nthreads = std::thread::hardware_concurrency();
+  }
+  nthreads = std::max(nthreads, 1);
+}
+
+libbirch::ThreadPool::~ThreadPool() {
+  std::unique_lock<std::mutex> guard(mutex);
+  stopping = true;
+  started.notify_all();
+  guard.unlock();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+int libbirch::ThreadPool::size() const {
+  return nthreads;
+}
+
+bool libbirch::ThreadPool::nested() const {
+  return get_thread_num() != 0 || active;
+}
+
+void libbirch::ThreadPool::run(const std::function<void(const int)>& f) {
+  assert(!nested());
+  if (nthreads == 1) {
+    f(0);
+  } else {
+    std::unique_lock<std::mutex> guard(mutex);
+    if (threads.empty()) {
+      for (int tid = 1; tid < nthreads; ++tid) {
+        threads.emplace_back(&ThreadPool::work, this, tid);
+      }
+    }
+    job = &f;
+    ++generation;
+    nbusy = nthreads - 1;
+    active = true;
+    started.notify_all();
+    guard.unlock();
+
+    f(0);
+
+    guard.lock();
+    finished.wait(guard, [this]() { return nbusy == 0; });
+    job = nullptr;
+    active = false;
+  }
+}
+
+void libbirch::ThreadPool::work(const int tid) {
+  threadNum = tid;
+  unsigned seen = 0u;
+  std::unique_lock<std::mutex> guard(mutex);
+  while (true) {
+    started.wait(guard, [&]() { return stopping || generation != seen; });
+    if (stopping) {
+      return;
+    }
+    seen = generation;
+    auto f = job;
+    guard.unlock();
+
+    (*f)(tid);
+
+    guard.lock();
+    if (--nbusy == 0) {
+      finished.notify_one();
+    }
+  }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include "libbirch/external.hpp"
+
+namespace libbirch {
+/**
+ * Pool of threads, used for parallelism when not building with OpenMP.
+ *
+ * @ingroup libbirch
+ *
+ * The calling thread is thread 0, and the pool starts the remaining threads
+ * on first use, then keeps them for subsequent use. The number of threads
+ * is given by the `OMP_NUM_THREADS` environment variable if set, as for
+ * OpenMP, otherwise by the number of hardware threads.
+ */
+class ThreadPool {
+public:
+  /**
+   * Constructor.
+   */
+  ThreadPool();
+
+  /**
+   * Destructor.
+   */
+  ~ThreadPool();
+
+  /**
+   * Number of threads, including the calling thread.
+   */
+  int size() const;
+
+  /**
+   * Is the calling thread already running a function on the pool?
+   */
+  bool nested() const;
+
+  /**
+   * Run a function once on each thread, returning when all have finished.
+   *
+   * @param f Function, called with the thread number.
+   */
+  void run(const std::function<void(const int)>& f);
+
+private:
+  /**
+   * Body of each thread other than thread 0.
+   *
+   * @param tid Thread number.
+   */
+  void work(const int tid);
+
+  /**
+   * Threads other than thread 0.
+   */
+  std::vector<std::thread> threads;
+
+  /**
+   * Mutex protecting all of the below.
+   */
+  std::mutex mutex;
+
+  /**
+   * Signalled when a function is ready to run, or the pool is stopping.
+   */
+  std::condition_variable started;
+
+  /**
+   * Signalled when the last thread finishes running a function.
+   */
+  std::condition_variable finished;
+
+  /**
+   * Function being run.
+   */
+  const std::function<void(const int)>* job;
+
+  /**
+   * Number of functions run so far, by which threads recognize a new one.
+   */
+  unsigned generation;
+
+  /**
+   * Number of threads, other than thread 0, still running the function.
+   */
+  int nbusy;
+
+  /**
+   * Number of threads.
+   */
+  int nthreads;
+
+  /**
+   * Is thread 0 running a function?
+   */
+  bool active;
+
+  /**
+   * Is the pool stopping?
+   */
+  bool stopping;
+};
+
+/**
+ * Get the thread pool.
+ */
+ThreadPool& thread_pool();
+}
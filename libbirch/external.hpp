@@ -10,6 +10,11 @@
 #include <limits>
 #include <utility>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <string>
@@ -19,12 +24,22 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cstdint>
 #include <cstddef>
 #include <cmath>
 #include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <getopt.h>
 #include <dlfcn.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #include <eigen3/Eigen/Dense>
 #include <eigen3/Eigen/Sparse>
@@ -6,6 +6,7 @@
  */
 #include "libbirch/memory.hpp"
 #include "libbirch/thread.hpp"
+#include "libbirch/TaskScheduler.hpp"
 
 /* declared in memory.hpp */
 libbirch::Atomic<size_t> libbirch::memoryUse(0);
@@ -42,6 +43,20 @@ size_t libbirch::bufferSize;
 #endif
 
 /* declared in thread.hpp */
+thread_local int libbirch::threadNum = 0;
+
+/* declared in ThreadPool.hpp */
+libbirch::ThreadPool& libbirch::thread_pool() {
+  static libbirch::ThreadPool pool;
+  return pool;
+}
+
+/* declared in TaskScheduler.hpp */
+libbirch::TaskScheduler& libbirch::task_scheduler() {
+  static libbirch::TaskScheduler scheduler;
+  return scheduler;
+}
+
 static libbirch::Label* root() {
   static libbirch::SharedPtr<libbirch::Label> context(new libbirch::Label());
   return context.get();
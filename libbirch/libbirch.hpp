@@ -14,6 +14,7 @@
 #include "libbirch/basic.hpp"
 #include "libbirch/type.hpp"
 #include "libbirch/thread.hpp"
+#include "libbirch/TaskScheduler.hpp"
 
 #include "libbirch/SharedPtr.hpp"
 #include "libbirch/WeakPtr.hpp"
@@ -25,10 +26,14 @@
 #include "libbirch/Shape.hpp"
 #include "libbirch/Slice.hpp"
 #include "libbirch/Array.hpp"
+#include "libbirch/ArrayFile.hpp"
+#include "libbirch/AsyncFile.hpp"
+#include "libbirch/BinaryFile.hpp"
 #include "libbirch/Tuple.hpp"
 #include "libbirch/Tie.hpp"
 #include "libbirch/Any.hpp"
 #include "libbirch/Optional.hpp"
+#include "libbirch/Philox.hpp"
 #include "libbirch/Nil.hpp"
 #include "libbirch/FiberState.hpp"
 #include "libbirch/Fiber.hpp"
@@ -10,6 +10,115 @@ libbirch::Pool& libbirch::pool(const int i) {
 }
 #endif
 
+namespace {
+/*
+ * Size class granularity, number of size classes, and maximum number of
+ * allocations kept in each free list, for recycled allocations.
+ */
+const size_t recycleGranularity = 16u;
+const int recycleClasses = 64;
+const int recycleCapacity = 256;
+
+/*
+ * Size of allocations in each size class.
+ */
+inline size_t recycleSize(const int i) {
+  return (i + 1)*recycleGranularity;
+}
+
+/*
+ * Has the current thread destroyed its free lists? Thread-local objects are
+ * destroyed before objects of static storage duration, and the latter may
+ * still deallocate objects, so from this point allocations go directly to
+ * and from the heap. Being trivially destructible, this flag remains valid
+ * after the free lists are destroyed.
+ */
+thread_local bool recycleBinsDestroyed = false;
+
+/*
+ * Number of allocations by allocate_recycled() on the current thread that
+ * reused a recycled allocation, and that did not. Like the flag above, these
+ * are trivially destructible.
+ */
+thread_local size_t recycleReused = 0u;
+thread_local size_t recycleFresh = 0u;
+
+/*
+ * Free lists of recycled allocations for a thread, one per size class. As
+ * with Pool, the first 8 bytes of each allocation on a list store a pointer
+ * to the next. The allocations are returned to the heap when the thread
+ * exits.
+ */
+struct RecycleBins {
+  void* top[recycleClasses] = {};
+  int count[recycleClasses] = {};
+
+  ~RecycleBins() {
+    recycleBinsDestroyed = true;
+    for (int i = 0; i < recycleClasses; ++i) {
+      while (top[i]) {
+        void* next = *reinterpret_cast<void**>(top[i]);
+        libbirch::deallocate(top[i], recycleSize(i),
+            libbirch::get_thread_num());
+        top[i] = next;
+      }
+    }
+  }
+};
+thread_local RecycleBins recycleBins;
+}
+
+void* libbirch::allocate_recycled(const size_t n) {
+  assert(n > 0u);
+  int i = (n - 1u)/recycleGranularity;
+  if (i >= recycleClasses) {
+    ++recycleFresh;
+    return allocate(n);
+  } else if (recycleBinsDestroyed) {
+    ++recycleFresh;
+    return allocate(recycleSize(i));
+  }
+  auto& bins = recycleBins;
+  void* ptr = bins.top[i];
+  if (ptr) {
+    bins.top[i] = *reinterpret_cast<void**>(ptr);
+    --bins.count[i];
+    ++recycleReused;
+  } else {
+    ptr = allocate(recycleSize(i));
+    ++recycleFresh;
+  }
+  return ptr;
+}
+
+size_t libbirch::recycled_allocations() {
+  return recycleReused;
+}
+
+size_t libbirch::fresh_allocations() {
+  return recycleFresh;
+}
+
+void libbirch::deallocate_recycled(void* ptr, const size_t n) {
+  assert(ptr);
+  assert(n > 0u);
+  int i = (n - 1u)/recycleGranularity;
+  if (i >= recycleClasses) {
+    deallocate(ptr, n, get_thread_num());
+  } else if (recycleBinsDestroyed) {
+    deallocate(ptr, recycleSize(i), get_thread_num());
+  } else {
+    auto& bins = recycleBins;
+    if (bins.count[i] < recycleCapacity) {
+      *reinterpret_cast<void**>(ptr) = bins.top[i];
+      bins.top[i] = ptr;
+      ++bins.count[i];
+    } else {
+      deallocate(ptr, recycleSize(i), get_thread_num());
+    }
+  }
+}
+
 void* libbirch::allocate(const size_t n) {
   assert(n > 0u);
 
@@ -169,6 +169,49 @@ void deallocate(void* ptr, const size_t n, const int tid);
  */
 void deallocate(void* ptr, const unsigned n, const int tid);
 
+/**
+ * Allocate memory for an object, reusing a recycled allocation of the same
+ * size class if one is available.
+ *
+ * @param n Number of bytes.
+ *
+ * @return Pointer to the allocated memory.
+ *
+ * Each thread keeps its own free lists of recycled allocations, in size
+ * classes of 16 bytes up to 1024 bytes, so that reuse requires no
+ * synchronization. Larger allocations are passed through to allocate().
+ */
+void* allocate_recycled(const size_t n);
+
+/**
+ * Deallocate memory previously allocated with allocate_recycled(), keeping
+ * it for reuse.
+ *
+ * @param ptr Pointer to the allocated memory.
+ * @param n Number of bytes.
+ *
+ * The allocation is pushed to the free list of the calling thread, which
+ * need not be the thread that allocated it. Each free list holds a bounded
+ * number of allocations; beyond that, they are passed through to
+ * deallocate(). They are also passed through once the free lists of the
+ * thread have been destroyed on its exit, as objects of static storage
+ * duration may still be released after that.
+ */
+void deallocate_recycled(void* ptr, const size_t n);
+
+/**
+ * Number of allocations made with allocate_recycled() by the calling
+ * thread that reused a recycled allocation.
+ */
+size_t recycled_allocations();
+
+/**
+ * Number of allocations made with allocate_recycled() by the calling
+ * thread that did not reuse a recycled allocation, and so were made with
+ * allocate().
+ */
+size_t fresh_allocations();
+
 /**
  * Reallocate memory from heap.
  *
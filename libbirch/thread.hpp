@@ -5,15 +5,21 @@
 
 #include "libbirch/external.hpp"
 #include "libbirch/EntryExitLock.hpp"
+#include "libbirch/ThreadPool.hpp"
 
 namespace libbirch {
 class Label;
 
+/**
+ * Number of the calling thread in the thread pool, when not using OpenMP.
+ */
+extern thread_local int threadNum;
+
 inline int get_max_threads() {
 #ifdef _OPENMP
   return omp_get_max_threads();
 #else
-  return 1;
+  return thread_pool().size();
 #endif
 }
 
@@ -21,7 +27,87 @@ inline int get_thread_num() {
 #ifdef _OPENMP
   return omp_get_thread_num();
 #else
-  return 0;
+  return threadNum;
+#endif
+}
+
+/**
+ * Is the calling thread in a parallel region?
+ */
+inline bool in_parallel() {
+#ifdef _OPENMP
+  return omp_in_parallel();
+#else
+  return thread_pool().nested();
+#endif
+}
+
+/**
+ * Run a function once on each thread. This uses OpenMP if enabled,
+ * otherwise the thread pool.
+ *
+ * @tparam F Function type.
+ *
+ * @param f Function, called with the thread number.
+ *
+ * If called from within a parallel region, @p f is called only once, on the
+ * calling thread.
+ */
+template<class F>
+void parallel(const F& f) {
+  if (in_parallel()) {
+    /* as a nested OpenMP parallel region would give the calling thread the
+     * thread number zero in a new team, call directly */
+    f(get_thread_num());
+    return;
+  }
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(get_max_threads())
+  {
+    f(get_thread_num());
+  }
+#else
+  thread_pool().run(f);
+#endif
+}
+
+/**
+ * Parallel loop. This uses OpenMP if enabled, otherwise the thread pool.
+ * Iterations are divided into contiguous blocks, one per thread.
+ *
+ * @tparam F Function type.
+ *
+ * @param first First index.
+ * @param last One past the last index.
+ * @param f Function, called with each index.
+ *
+ * If called from within a parallel region, the loop is run on the calling
+ * thread only.
+ */
+template<class F>
+void parallel_for(const int64_t first, const int64_t last, const F& f) {
+  if (in_parallel()) {
+    /* as for parallel(), keep the thread number of the calling thread */
+    for (int64_t i = first; i < last; ++i) {
+      f(i);
+    }
+    return;
+  }
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(get_max_threads()) schedule(static)
+  for (int64_t i = first; i < last; ++i) {
+    f(i);
+  }
+#else
+  auto n = last - first;
+  auto nthreads = get_max_threads();
+  thread_pool().run([&](const int tid) {
+    auto from = first + n*tid/nthreads;
+    auto to = first + n*(tid + 1)/nthreads;
+    for (int64_t i = from; i < to; ++i) {
+      f(i);
+    }
+  });
 #endif
 }
 